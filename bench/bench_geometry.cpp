@@ -0,0 +1,158 @@
+// bench/bench_geometry.cpp
+// Per-candidate cost of the quad geometry kernels against the previous
+// std::vector<Point2f> implementations.
+#include "geometry_utils.h"
+#include "contour_analysis.h"
+#include "evaluation.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace legacy
+{
+// Previous implementations, kept here as the baseline
+
+void orderCCW(std::vector<Point2f> &q)
+{
+    Point2f c(0, 0);
+    for (auto &p : q)
+        c += p;
+    c *= 0.25f;
+
+    std::sort(q.begin(), q.end(), [&](const auto &a, const auto &b)
+              { return std::atan2(a.y - c.y, a.x - c.x) < std::atan2(b.y - c.y, b.x - c.x); });
+
+    size_t tl = 0;
+    for (size_t i = 1; i < 4; i++)
+    {
+        if (q[i].y < q[tl].y || (q[i].y == q[tl].y && q[i].x < q[tl].x))
+        {
+            tl = i;
+        }
+    }
+    std::rotate(q.begin(), q.begin() + tl, q.end());
+}
+
+bool crossSelf(const std::vector<Point2f> &q)
+{
+    auto z = [](Point2f a, Point2f b, Point2f c)
+    {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    };
+    return z(q[0], q[1], q[2]) * z(q[0], q[1], q[3]) < 0 &&
+           z(q[2], q[3], q[0]) * z(q[2], q[3], q[1]) < 0;
+}
+
+double borderFrac(const std::vector<Point2f> &q, int W, int H)
+{
+    double touch = 0, per = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        auto a = q[i], b = q[(i + 1) & 3];
+        double len = cv::norm(a - b);
+        per += len;
+        if ((a.x < 2 && b.x < 2) || (a.x > W - 3 && b.x > W - 3) ||
+            (a.y < 2 && b.y < 2) || (a.y > H - 3 && b.y > H - 3))
+        {
+            touch += len;
+        }
+    }
+    return touch / per;
+}
+
+double IoU(std::vector<Point2f> a, std::vector<Point2f> b)
+{
+    std::vector<cv::Point> A, B;
+    for (auto &p : a)
+        A.emplace_back(p);
+    for (auto &p : b)
+        B.emplace_back(p);
+
+    double a1 = fabs(cv::contourArea(A));
+    double a2 = fabs(cv::contourArea(B));
+
+    cv::Mat inter;
+    bool ok = cv::intersectConvexConvex(A, B, inter);
+    double ai = (ok && !inter.empty()) ? fabs(cv::contourArea(inter)) : 0;
+
+    return (a1 + a2 - ai) > 1e-5 ? ai / (a1 + a2 - ai) : 0;
+}
+} // namespace legacy
+
+int main(int argc, char **argv)
+{
+    const int W = 450, H = 600;
+    int N = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    // Rotated rectangles of random size, as produced by minAreaRect
+    cv::RNG rng(12345);
+    std::vector<Quad> quads(N);
+    for (auto &q : quads)
+    {
+        cv::RotatedRect rr({rng.uniform(0.f, (float)W), rng.uniform(0.f, (float)H)},
+                           {rng.uniform(20.f, (float)W), rng.uniform(20.f, (float)H)},
+                           rng.uniform(0.f, 180.f));
+        rr.points(q.p);
+    }
+
+    // Candidate filtering as done by evalQuad before the image-based terms
+    double sink = 0;
+    cv::TickMeter tOld, tNew;
+
+    tOld.start();
+    for (auto &src : quads)
+    {
+        std::vector<Point2f> q = src.vec();
+        legacy::orderCCW(q);
+        if (legacy::crossSelf(q))
+            continue;
+        double A = fabs(cv::contourArea(q));
+        double bF = legacy::borderFrac(q, W, H);
+        double ar = std::max(cv::norm(q[0] - q[1]), cv::norm(q[1] - q[2])) /
+                    std::min(cv::norm(q[0] - q[1]), cv::norm(q[1] - q[2]));
+        sink += A + bF + ar;
+    }
+    tOld.stop();
+
+    tNew.start();
+    for (auto &src : quads)
+    {
+        Quad q = src;
+        orderCCW(q);
+        if (crossSelf(q))
+            continue;
+        double A = quadArea(q);
+        QuadEdges len = edgeLengths(q);
+        double bF = borderFrac(q, len, W, H);
+        double ar = (double)std::max(len[0], len[1]) / std::min(len[0], len[1]);
+        sink += A + bF + ar;
+    }
+    tNew.stop();
+
+    // IoU against a fixed reference quad
+    Quad ref{{Point2f(50, 60), Point2f(400, 70), Point2f(390, 540), Point2f(60, 530)}};
+    std::vector<Point2f> refV = ref.vec();
+    cv::TickMeter iOld, iNew;
+
+    iOld.start();
+    for (auto &q : quads)
+        sink += legacy::IoU(q.vec(), refV);
+    iOld.stop();
+
+    iNew.start();
+    for (auto &q : quads)
+        sink += IoU(q, ref);
+    iNew.stop();
+
+    auto ns = [N](const cv::TickMeter &t)
+    { return t.getTimeMicro() * 1000.0 / N; };
+    std::cout << "candidates: " << N << " (checksum " << sink << ")\n"
+              << "geometry  vector: " << ns(tOld) << " ns  Quad: " << ns(tNew)
+              << " ns  speedup " << tOld.getTimeMicro() / tNew.getTimeMicro() << "x\n"
+              << "IoU       vector: " << ns(iOld) << " ns  Quad: " << ns(iNew)
+              << " ns  speedup " << iOld.getTimeMicro() / iNew.getTimeMicro() << "x\n";
+    return 0;
+}
@@ -2,6 +2,8 @@
 #ifndef CONTOUR_ANALYSIS_H_
 #define CONTOUR_ANALYSIS_H_
 
+#include "geometry_utils.h"
+#include "image_context.h"
 #include <opencv2/opencv.hpp>
 #include <vector>
 
@@ -14,32 +16,37 @@ using cv::Point2f;
 
 /**
  * Calculates mean edge strength along quadrilateral edges.
+ * sob is the cross-derivative Sobel plane from ImageContext::sobel().
  */
-double edgeMean(const std::vector<Point2f> &q, const Mat &eq);
+double edgeMean(const Quad &q, const Mat &sob);
 
 /**
  * Calculates fraction of quadrilateral perimeter touching image borders.
+ * len holds the edge lengths from edgeLengths(q).
  */
-double borderFrac(const std::vector<Point2f> &q, int W, int H);
+double borderFrac(const Quad &q, const QuadEdges &len, int W, int H);
 
 /**
  * Calculates whiteness score comparing document interior to background.
+ * The interior mask covers only the quad's bounding box; the background
+ * sum is graySum minus the interior sum.
  */
-double whiteness(const std::vector<Point2f> &q, const Mat &gray);
+double whiteness(const Quad &q, const Mat &gray, double graySum);
 
 /**
  * Candidate structure for quadrilateral scoring.
  */
 struct Cand
 {
-    std::vector<Point2f> q;
+    Quad q;
     double sc;
 };
 
 /**
  * Evaluates a quadrilateral and adds it to candidate list if valid.
+ * With DOCSCAN_FIXED_POINT every fit is computed in Q15 integer arithmetic
+ * on corners rounded to pixels.
  */
-void evalQuad(std::vector<Point2f> q, std::vector<Cand> &list,
-              double Aimg, int W, int H, const Mat &eq, const Mat &gray, double medGrad);
+void evalQuad(const Quad &q, std::vector<Cand> &list, ImageContext &ctx);
 
 #endif // CONTOUR_ANALYSIS_H_
\ No newline at end of file
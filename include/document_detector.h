@@ -2,16 +2,53 @@
 #ifndef DOCUMENT_DETECTOR_H_
 #define DOCUMENT_DETECTOR_H_
 
+#include "geometry_utils.h"
+#include "image_context.h"
 #include <opencv2/opencv.hpp>
 #include <vector>
 
 using cv::Mat;
 using cv::Point2f;
 
+/**
+ * Options controlling candidate generation in detect().
+ */
+struct DetectOptions
+{
+    // Use the contour hierarchy to skip nested contours (text, logos, cells)
+    // whose outer or parent-level ancestor already produced a strong quad.
+    // Off by default until its IoU impact is measured with --dataset --prune.
+    bool hierarchy = false;
+
+    // Score only the largest contours by area; 0 scores all of them.
+    // Used for images the scan-quality gate classifies as easy.
+    size_t maxContours = 0;
+};
+
+/**
+ * Candidate counters filled by detect().
+ */
+struct DetectStats
+{
+    size_t contours = 0; // contours returned by findContours
+    size_t scored = 0;   // contours whose quads were evaluated
+    size_t pruned = 0;   // nested contours skipped by hierarchy pruning
+    size_t skipped = 0;  // contours outside the maxContours largest
+    size_t quads = 0;    // quads that passed the evalQuad filters
+    double ms = 0;       // wall time of detect()
+};
+
 /**
  * Main document detection function.
  * Detects document corners in the input image.
  */
-std::vector<Point2f> detect(const Mat &img);
+Quad detect(const Mat &img, const DetectOptions &opt = {},
+            DetectStats *stats = nullptr);
+
+/**
+ * Detects document corners reusing the planes memoized in ctx.
+ */
+Quad detect(ImageContext &ctx, const DetectOptions &opt = {},
+            DetectStats *stats = nullptr);
 
-#endif // DOCUMENT_DETECTOR_H_
\ No newline at end of file
+#endif // DOCUMENT_DETECTOR_H_
@@ -2,10 +2,8 @@
 #ifndef EVALUATION_H_
 #define EVALUATION_H_
 
+#include "geometry_utils.h"
 #include <opencv2/opencv.hpp>
-#include <vector>
-
-using cv::Point2f;
 
 /**
  * Evaluation metrics for document detection accuracy.
@@ -14,6 +12,6 @@ using cv::Point2f;
 /**
  * Calculates Intersection over Union (IoU) between two quadrilaterals.
  */
-double IoU(std::vector<Point2f> a, std::vector<Point2f> b);
+double IoU(const Quad &a, const Quad &b);
 
 #endif // EVALUATION_H_
\ No newline at end of file
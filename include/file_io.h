@@ -1,8 +1,10 @@
 #ifndef FILE_IO_H_
 #define FILE_IO_H_
 
+#include "geometry_utils.h"
 #include <opencv2/opencv.hpp>
 #include <filesystem>
+#include <optional>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -17,17 +19,18 @@ using cv::Point2f;
 /**
  * Saves quadrilateral coordinates to text file.
  */
-void saveTxt(const fs::path& p, const std::vector<Point2f>& q);
+void saveTxt(const fs::path& p, const Quad& q);
 
 /**
  * Reads ground truth coordinates from the specific coordinates.txt format.
  * Format: img_X: "x1 y1"	"x2 y2" 	"x3 y3" 	"x4 y4"
+ * Returns no quad if the file cannot be read or the entry is malformed.
  */
-std::vector<Point2f> readGtFromCoordinatesFile(const fs::path& coordFile, const std::string& imageName);
+std::optional<Quad> readGtFromCoordinatesFile(const fs::path& coordFile, const std::string& imageName);
 
 /**
  * Reads ground truth coordinates from text file.
  */
-std::vector<Point2f> readGt(const fs::path& t);
+std::optional<Quad> readGt(const fs::path& t);
 
 #endif  // FILE_IO_H_
@@ -3,6 +3,9 @@
 #define GEOMETRY_UTILS_H_
 
 #include <opencv2/opencv.hpp>
+#include <array>
+#include <cmath>
+#include <filesystem>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -15,18 +18,102 @@ using cv::Point2f;
  */
 
 /**
- * Orders four points in counter-clockwise order starting from top-left.
+ * Quadrilateral with its four corners stored inline (no heap).
+ */
+struct Quad
+{
+    Point2f p[4];
+
+    Point2f &operator[](int i) { return p[i]; }
+    const Point2f &operator[](int i) const { return p[i]; }
+
+    Point2f *begin() { return p; }
+    Point2f *end() { return p + 4; }
+    const Point2f *begin() const { return p; }
+    const Point2f *end() const { return p + 4; }
+
+    std::vector<Point2f> vec() const { return std::vector<Point2f>(p, p + 4); }
+};
+
+/**
+ * Lengths of edges q[i] -> q[i + 1].
+ */
+using QuadEdges = std::array<float, 4>;
+
+/**
+ * z component of (a - o) x (b - o).
+ */
+inline float cross(Point2f o, Point2f a, Point2f b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/**
+ * Computes the four edge lengths once so callers can share them.
  */
-void orderCCW(std::vector<Point2f> &q);
+inline QuadEdges edgeLengths(const Quad &q)
+{
+    QuadEdges len;
+    for (int i = 0; i < 4; i++)
+    {
+        Point2f d = q[(i + 1) & 3] - q[i];
+        len[i] = std::sqrt(d.x * d.x + d.y * d.y);
+    }
+    return len;
+}
+
+/**
+ * Unsigned area (shoelace formula).
+ */
+inline double quadArea(const Quad &q)
+{
+    double s = 0;
+    for (int i = 0; i < 4; i++)
+        s += (double)q[i].x * q[(i + 1) & 3].y - (double)q[(i + 1) & 3].x * q[i].y;
+    return std::abs(s) * 0.5;
+}
+
+/**
+ * Checks that all turns have the same sign.
+ */
+inline bool isConvex(const Quad &q)
+{
+    int pos = 0, neg = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        float z = cross(q[i], q[(i + 1) & 3], q[(i + 2) & 3]);
+        pos += z > 0;
+        neg += z < 0;
+    }
+    return !(pos && neg);
+}
 
 /**
  * Checks if a quadrilateral is self-intersecting.
  */
-bool crossSelf(const std::vector<Point2f> &q);
+inline bool crossSelf(const Quad &q)
+{
+    return cross(q[0], q[1], q[2]) * cross(q[0], q[1], q[3]) < 0 &&
+           cross(q[2], q[3], q[0]) * cross(q[2], q[3], q[1]) < 0;
+}
+
+/**
+ * Orders four points in counter-clockwise order starting from top-left.
+ */
+void orderCCW(Quad &q);
 
 /**
  * Clips a point to be within image boundaries.
  */
 void clipPt(Point2f &p, int W, int H);
 
-#endif // GEOMETRY_UTILS_H_
\ No newline at end of file
+/**
+ * Clips all corners to be within image boundaries.
+ */
+inline void clipQuad(Quad &q, int W, int H)
+{
+    for (auto &p : q)
+        clipPt(p, W, H);
+}
+
+#endif // GEOMETRY_UTILS_H_
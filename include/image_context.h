@@ -0,0 +1,77 @@
+// include/image_context.h
+#ifndef IMAGE_CONTEXT_H_
+#define IMAGE_CONTEXT_H_
+
+#include <opencv2/opencv.hpp>
+
+using cv::Mat;
+
+#ifdef DOCSCAN_FIXED_POINT
+constexpr int kSobelDepth = CV_16S;
+#else
+constexpr int kSobelDepth = CV_32F;
+#endif
+
+/**
+ * Per-image working set shared by the pipeline stages.
+ * Derived planes are computed on first access and memoized, so each one
+ * is built once per image no matter how many stages read it.
+ */
+class ImageContext
+{
+public:
+    explicit ImageContext(const Mat &img);
+
+    int width() const { return img_.cols; }
+    int height() const { return img_.rows; }
+    double area() const { return (double)img_.total(); }
+
+    /**
+     * Input BGR image (not copied).
+     */
+    const Mat &bgr() const { return img_; }
+
+    /**
+     * Grayscale conversion of the input.
+     */
+    const Mat &gray();
+
+    /**
+     * CLAHE-equalized grayscale.
+     */
+    const Mat &eq();
+
+    /**
+     * Cross-derivative Sobel of eq(), sampled by edgeMean().
+     * Depth is kSobelDepth.
+     */
+    const Mat &sobel();
+
+    /**
+     * Binary edge mask used for contour extraction.
+     */
+    const Mat &mag();
+
+    /**
+     * Median gradient of the edge mask.
+     */
+    double medGrad();
+
+    /**
+     * Sum of all gray() values.
+     */
+    double graySum();
+
+    /**
+     * Bytes held by the memoized planes only. Transient buffers allocated
+     * while building them or during scoring are not counted.
+     */
+    size_t bytes() const;
+
+private:
+    Mat img_, gray_, eq_, sob_, mag_;
+    double medGrad_ = 0;
+    double graySum_ = -1;
+};
+
+#endif // IMAGE_CONTEXT_H_
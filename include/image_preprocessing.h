@@ -11,9 +11,15 @@ using cv::Mat;
  */
 
 /**
- * Preprocesses image and returns median gradient value.
- * Applies CLAHE, Sobel operators, thresholding, and morphological operations.
+ * Applies CLAHE to a grayscale image.
  */
-double preprocessImage(const Mat &img, Mat &mag, Mat &eq);
+void equalize(const Mat &gray, Mat &eq);
 
-#endif // IMAGE_PREPROCESSING_H_
\ No newline at end of file
+/**
+ * Builds the binary edge mask from the equalized image and returns the
+ * median gradient value.
+ * Applies Sobel operators, thresholding, and morphological operations.
+ */
+double edgeMask(const Mat &eq, Mat &mag);
+
+#endif // IMAGE_PREPROCESSING_H_
@@ -0,0 +1,60 @@
+// include/scan_quality.h
+#ifndef SCAN_QUALITY_H_
+#define SCAN_QUALITY_H_
+
+#include <opencv2/opencv.hpp>
+#include <array>
+
+using cv::Mat;
+
+/**
+ * Fast scan-quality gate run on a thumbnail before full detection.
+ */
+
+/**
+ * Routing decision for an image.
+ */
+enum class ScanClass
+{
+    Reject, // not worth detecting
+    Easy,   // clean background, reduced candidate set
+    Hard    // full pipeline
+};
+
+/**
+ * Why an image was rejected.
+ */
+enum class RejectReason
+{
+    None,
+    Underexposed,
+    Overexposed,
+    Blank,
+    Blurry,
+    NoEdges
+};
+
+/**
+ * Thumbnail measurements and the resulting class.
+ */
+struct ScanQuality
+{
+    ScanClass cls = ScanClass::Hard;
+    RejectReason reason = RejectReason::None;
+    double sharpness = 0;   // |Laplacian| / L1 gradient on edges, low means blurry
+    double exposure = 0;    // mean gray level
+    double contrast = 0;    // gray standard deviation
+    double edgeDensity = 0; // fraction of pixels with L1 gradient >= 128
+    std::array<float, 8> edgeHist{}; // normalized L1 gradient histogram, bins of 128
+};
+
+/**
+ * Measures exposure and edge density on a thumbnail of img and sharpness on
+ * a 300 px copy, and classifies it as reject, easy or hard.
+ */
+ScanQuality assessScan(const Mat &img);
+
+const char *toString(ScanClass c);
+const char *toString(RejectReason r);
+
+#endif // SCAN_QUALITY_H_
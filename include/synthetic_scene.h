@@ -0,0 +1,45 @@
+// include/synthetic_scene.h
+#ifndef SYNTHETIC_SCENE_H_
+#define SYNTHETIC_SCENE_H_
+
+#include "geometry_utils.h"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+using cv::Mat;
+
+/**
+ * Synthetic document scenes with known corners, for regression tests and
+ * as a load generator. Output depends only on the seed and parameters.
+ */
+
+/**
+ * Rendering parameters.
+ */
+struct SceneParams
+{
+    int width = 450;
+    int height = 600;
+    double perspective = 0.08; // max corner offset, fraction of page width
+    double blur = 1.0;         // Gaussian sigma, 0 disables
+    double noise = 4.0;        // Gaussian noise stddev in gray levels
+    int clutter = 6;           // distractor shapes drawn on the background
+    int background = -1;       // 0 flat, 1 gradient, 2 stripes, 3 texture; -1 picks from seed
+};
+
+/**
+ * Rendered image with its ground truth quad (ordered by orderCCW).
+ */
+struct Scene
+{
+    Mat img;
+    Quad quad;
+};
+
+/**
+ * Renders a page with text lines onto a background, warped by a random
+ * perspective, then blurred and noised.
+ */
+Scene renderScene(uint64_t seed, const SceneParams &p = {});
+
+#endif // SYNTHETIC_SCENE_H_
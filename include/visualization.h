@@ -2,9 +2,9 @@
 #ifndef VISUALIZATION_H_
 #define VISUALIZATION_H_
 
+#include "geometry_utils.h"
 #include <opencv2/opencv.hpp>
 #include <filesystem>
-#include <vector>
 
 namespace fs = std::filesystem;
 using cv::Mat;
@@ -15,9 +15,8 @@ using cv::Point2f;
  */
 
 /**
- * Draws detected and ground truth boxes on image and saves result.
+ * Draws detected and ground truth boxes on image in place and saves result.
  */
-void drawBoxes(const Mat &img, const std::vector<Point2f> &detected,
-               const std::vector<Point2f> &gt, const fs::path &outputPath);
+void drawBoxes(Mat &img, const Quad &detected, const Quad &gt, const fs::path &outputPath);
 
 #endif // VISUALIZATION_H_
\ No newline at end of file
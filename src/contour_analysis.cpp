@@ -1,12 +1,40 @@
 // src/contour_analysis.cpp
 #include "contour_analysis.h"
 #include "geometry_utils.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 
-double edgeMean(const std::vector<Point2f> &q, const Mat &eq)
+#ifdef DOCSCAN_FIXED_POINT
+/**
+ * Integer sum of |sob| along the quad edges; n receives the sample count.
+ */
+static int64_t edgeSum(const Quad &q, const Mat &sob, int64_t &n)
+{
+    int64_t s = 0;
+    n = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        cv::LineIterator it(sob, q[i], q[(i + 1) & 3], 8);
+        for (int j = 0; j < it.count; ++j, ++it)
+        {
+            s += std::abs(*reinterpret_cast<const short *>(*it));
+            ++n;
+        }
+    }
+    return s;
+}
+
+double edgeMean(const Quad &q, const Mat &sob)
+{
+    int64_t n;
+    int64_t s = edgeSum(q, sob, n);
+    return n ? (double)s / n : 0;
+}
+#else
+double edgeMean(const Quad &q, const Mat &sob)
 {
-    Mat sob;
-    cv::Sobel(eq, sob, CV_32F, 1, 1);
     double s = 0;
     int n = 0;
 
@@ -15,72 +43,217 @@ double edgeMean(const std::vector<Point2f> &q, const Mat &eq)
         cv::LineIterator it(sob, q[i], q[(i + 1) & 3], 8);
         for (int j = 0; j < it.count; ++j, ++it)
         {
-            s += static_cast<double>((*it)[0]); // Remove abs since uchar is always positive
+            // Baseline behaviour: reads the first byte of each float sample.
+            // The scoring weights were tuned on it, so it stays until re-measured
+            s += static_cast<double>((*it)[0]);
             ++n;
         }
     }
     return n ? s / n : 0;
 }
+#endif
 
-double borderFrac(const std::vector<Point2f> &q, int W, int H)
+double borderFrac(const Quad &q, const QuadEdges &len, int W, int H)
 {
     double touch = 0, per = 0;
     for (int i = 0; i < 4; i++)
     {
         auto a = q[i], b = q[(i + 1) & 3];
-        double len = cv::norm(a - b);
-        per += len;
+        per += len[i];
         if ((a.x < 2 && b.x < 2) || (a.x > W - 3 && b.x > W - 3) ||
             (a.y < 2 && b.y < 2) || (a.y > H - 3 && b.y > H - 3))
         {
-            touch += len;
+            touch += len[i];
         }
     }
     return touch / per;
 }
 
-double whiteness(const std::vector<Point2f> &q, const Mat &gray)
+double whiteness(const Quad &q, const Mat &gray, double graySum)
 {
-    std::vector<cv::Point> poly;
-    for (auto &p : q)
-        poly.emplace_back(p);
+    cv::Point poly[4];
+    for (int i = 0; i < 4; i++)
+        poly[i] = q[i];
 
-    Mat mask = Mat::zeros(gray.size(), CV_8U);
-    cv::fillConvexPoly(mask, poly, 255);
+    // Rasterize the quad into a mask over its bounding box only
+    cv::Rect box = cv::boundingRect(Mat(4, 1, CV_32SC2, poly)) & cv::Rect(0, 0, gray.cols, gray.rows);
+    double sDoc = 0, nDoc = 0;
+    if (!box.empty())
+    {
+        for (auto &p : poly)
+            p -= box.tl();
+        Mat mask = Mat::zeros(box.size(), CV_8U);
+        cv::fillConvexPoly(mask, poly, 4, 255);
+        nDoc = cv::countNonZero(mask);
+        sDoc = cv::mean(gray(box), mask)[0] * nDoc;
+    }
 
-    cv::Scalar mDoc = cv::mean(gray, mask);
-    cv::Scalar mBg = cv::mean(gray, 255 - mask);
+    double sAll = graySum;
+    double nBg = (double)gray.total() - nDoc;
+    double mDoc = nDoc > 0 ? sDoc / nDoc : 0;
+    double mBg = nBg > 0 ? (sAll - sDoc) / nBg : 0;
 
-    double w = (mBg[0] > 1) ? mDoc[0] / mBg[0] : 1;
+    double w = (mBg > 1) ? mDoc / mBg : 1;
     if (w < 1)
         w = 1 / w;
     return std::clamp((w - 1) / 0.5, 0.0, 1.0);
 }
 
-void evalQuad(std::vector<Point2f> q, std::vector<Cand> &list,
-              double Aimg, int W, int H, const Mat &eq, const Mat &gray, double medGrad)
+#ifdef DOCSCAN_FIXED_POINT
+// Fixed-point scoring: every fit is a Q15 integer computed from corners
+// rounded to pixels, mirroring the float formulas below
+static const int64_t kOne = 1 << 15;
+
+static int64_t isqrt(int64_t v)
+{
+    int64_t r = (int64_t)std::sqrt((double)v);
+    while (r * r > v)
+        --r;
+    while ((r + 1) * (r + 1) <= v)
+        ++r;
+    return r;
+}
+
+static int64_t crossI(Point o, Point a, Point b)
+{
+    return (int64_t)(a.x - o.x) * (b.y - o.y) - (int64_t)(a.y - o.y) * (b.x - o.x);
+}
+
+/**
+ * Integer counterpart of whiteness(): interior and background means in Q8,
+ * their ratio in Q15.
+ */
+static int64_t whitenessQ15(const Point c[4], const Mat &gray, int64_t graySum)
+{
+    Point poly[4] = {c[0], c[1], c[2], c[3]};
+    cv::Rect box = cv::boundingRect(Mat(4, 1, CV_32SC2, poly)) & cv::Rect(0, 0, gray.cols, gray.rows);
+    int64_t sDoc = 0, nDoc = 0;
+    if (!box.empty())
+    {
+        for (auto &p : poly)
+            p -= box.tl();
+        Mat mask = Mat::zeros(box.size(), CV_8U);
+        cv::fillConvexPoly(mask, poly, 4, 255);
+        for (int r = 0; r < box.height; r++)
+        {
+            const uchar *g = gray.ptr<uchar>(box.y + r) + box.x;
+            const uchar *m = mask.ptr<uchar>(r);
+            for (int x = 0; x < box.width; x++)
+            {
+                if (m[x])
+                {
+                    sDoc += g[x];
+                    ++nDoc;
+                }
+            }
+        }
+    }
+
+    int64_t nBg = (int64_t)gray.total() - nDoc;
+    int64_t mDoc = nDoc > 0 ? (sDoc << 8) / nDoc : 0;
+    int64_t mBg = nBg > 0 ? ((graySum - sDoc) << 8) / nBg : 0;
+
+    int64_t w = (mBg > 256) ? mDoc * kOne / mBg : kOne;
+    if (w < kOne)
+        w = mDoc > 0 ? mBg * kOne / mDoc : 2 * kOne;
+    return std::clamp<int64_t>((w - kOne) * 2, 0, kOne);
+}
+
+void evalQuad(const Quad &q, std::vector<Cand> &list, ImageContext &ctx)
+{
+    int W = ctx.width(), H = ctx.height();
+    int64_t Aimg2 = 2 * (int64_t)W * H;
+
+    Point c[4];
+    for (int i = 0; i < 4; i++)
+        c[i] = q[i];
+
+    if (crossI(c[0], c[1], c[2]) * crossI(c[0], c[1], c[3]) < 0 &&
+        crossI(c[2], c[3], c[0]) * crossI(c[2], c[3], c[1]) < 0)
+        return;
+
+    // Twice the shoelace area
+    int64_t A2 = 0;
+    for (int i = 0; i < 4; i++)
+        A2 += (int64_t)c[i].x * c[(i + 1) & 3].y - (int64_t)c[(i + 1) & 3].x * c[i].y;
+    A2 = std::abs(A2);
+    if (A2 * 1000 < 29 * Aimg2)
+        return;
+
+    int64_t len[4], touch = 0, per = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        Point a = c[i], b = c[(i + 1) & 3], d = b - a;
+        len[i] = isqrt((int64_t)d.x * d.x + (int64_t)d.y * d.y);
+        per += len[i];
+        if ((a.x < 2 && b.x < 2) || (a.x > W - 3 && b.x > W - 3) ||
+            (a.y < 2 && b.y < 2) || (a.y > H - 3 && b.y > H - 3))
+        {
+            touch += len[i];
+        }
+    }
+    if (touch * 1000 > 476 * per)
+        return;
+
+    int64_t T2 = 458 * Aimg2 / 1000;
+    int64_t areaFit = kOne - std::abs(A2 - T2) * kOne / T2;
+
+    // 1.414 in Q15 is 46334
+    int64_t lo = std::min(len[0], len[1]), hi = std::max(len[0], len[1]);
+    int64_t ARfit = 0;
+    if (lo > 0)
+        ARfit = kOne - std::min<int64_t>(std::abs(hi * kOne / lo - 46334), kOne);
+
+    int64_t medGrad = std::llround(ctx.medGrad());
+    int64_t gradFit = kOne / 2;
+    if (medGrad > 1)
+    {
+        // em / (em + medGrad) with em = s / n, kept as integer sums
+        int64_t n;
+        int64_t s = edgeSum(q, ctx.sobel(), n);
+        if (s + medGrad * n > 0)
+            gradFit = s * kOne / (s + medGrad * n);
+    }
+    int64_t wFit = whitenessQ15(c, ctx.gray(), std::llround(ctx.graySum()));
+
+    // Optimized weights in Q15, summing to 1 << 15; score accumulated in Q30
+    int64_t acc = 10781 * areaFit + 8716 * wFit + 6816 * gradFit + 6455 * ARfit;
+    list.push_back({q, (double)acc / (kOne * kOne)});
+}
+#else
+void evalQuad(const Quad &q, std::vector<Cand> &list, ImageContext &ctx)
 {
+    int W = ctx.width(), H = ctx.height();
+    double Aimg = ctx.area();
+
     if (crossSelf(q))
         return;
 
-    double A = fabs(cv::contourArea(q));
+    double A = quadArea(q);
     if (A < 0.029 * Aimg)
         return;
 
-    double bF = borderFrac(q, W, H);
+    QuadEdges len = edgeLengths(q);
+    double bF = borderFrac(q, len, W, H);
     if (bF > 0.476)
         return;
 
     double areaFit = 1 - std::abs(A - 0.458 * Aimg) / (0.458 * Aimg);
 
-    double ar = std::max(cv::norm(q[0] - q[1]), cv::norm(q[1] - q[2])) /
-                std::min(cv::norm(q[0] - q[1]), cv::norm(q[1] - q[2]));
+    double ar = (double)std::max(len[0], len[1]) / std::min(len[0], len[1]);
     double ARfit = 1 - std::min(std::abs(ar - 1.414) / 1.0, 1.0);
 
-    double gradFit = medGrad > 1 ? std::clamp(edgeMean(q, eq) / (edgeMean(q, eq) + medGrad), 0.0, 1.0) : 0.5;
-    double wFit = whiteness(q, gray);
+    double medGrad = ctx.medGrad();
+    double gradFit = 0.5;
+    if (medGrad > 1)
+    {
+        double em = edgeMean(q, ctx.sobel());
+        gradFit = std::clamp(em / (em + medGrad), 0.0, 1.0);
+    }
+    double wFit = whiteness(q, ctx.gray(), ctx.graySum());
 
     // Optimized weights
     double score = 0.329 * areaFit + 0.266 * wFit + 0.208 * gradFit + 0.197 * ARfit;
     list.push_back({q, score});
-}
\ No newline at end of file
+}
+#endif
@@ -1,6 +1,5 @@
 // src/document_detector.cpp
 #include "document_detector.h"
-#include "image_preprocessing.h"
 #include "contour_analysis.h"
 #include "geometry_utils.h"
 #ifdef HAVE_OPENCV_XIMGPROC
@@ -8,54 +7,129 @@
 #endif
 #include <algorithm>
 
-std::vector<Point2f> detect(const Mat &img)
+// Score at which a contour's quad is taken as the document, so its nested
+// contours are not scored in hierarchy mode
+static const double kStrongQuad = 0.6;
+
+Quad detect(const Mat &img, const DetectOptions &opt, DetectStats *stats)
 {
-    int W = img.cols, H = img.rows;
-    double Aimg = img.total();
+    ImageContext ctx(img);
+    return detect(ctx, opt, stats);
+}
 
-    // Preprocess image
-    Mat mag, eq;
-    double medGrad = preprocessImage(img, mag, eq);
+Quad detect(ImageContext &ctx, const DetectOptions &opt, DetectStats *stats)
+{
+    cv::TickMeter tm;
+    tm.start();
+    int W = ctx.width(), H = ctx.height();
 
     // Find contours
     std::vector<std::vector<cv::Point>> C;
-    cv::findContours(mag, C, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+    std::vector<cv::Vec4i> hier;
+    cv::findContours(ctx.mag(), C, hier, opt.hierarchy ? cv::RETR_TREE : cv::RETR_LIST,
+                     cv::CHAIN_APPROX_SIMPLE);
 
-    // Convert to grayscale for scoring functions
-    Mat gray;
-    cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
+    // Approximated quads and minimum area rectangles are collected separately
+    // and concatenated, keeping the baseline candidate order for max_element
+    std::vector<Cand> list, rects;
 
-    std::vector<Cand> list;
+    // Nesting depth of each contour; parents are visited before children
+    std::vector<int> depth(C.size(), 0);
+    std::vector<size_t> order(C.size());
+    for (size_t i = 0; i < C.size(); i++)
+    {
+        order[i] = i;
+        if (opt.hierarchy)
+            for (int p = hier[i][3]; p >= 0; p = hier[p][3])
+                depth[i]++;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                     { return depth[a] < depth[b]; });
 
-    // 1. Polygon approximation with 4 sides
-    for (auto &cont : C)
+    // Reduced candidate set: keep the maxContours largest contours
+    std::vector<char> keep(C.size(), 1);
+    if (opt.maxContours > 0 && C.size() > opt.maxContours)
     {
+        std::vector<double> area(C.size());
+        std::vector<size_t> byArea(C.size());
+        for (size_t i = 0; i < C.size(); i++)
+        {
+            area[i] = fabs(cv::contourArea(C[i]));
+            byArea[i] = i;
+        }
+        std::nth_element(byArea.begin(), byArea.begin() + opt.maxContours, byArea.end(),
+                         [&](size_t a, size_t b)
+                         { return area[a] > area[b]; });
+        for (size_t k = opt.maxContours; k < byArea.size(); k++)
+            keep[byArea[k]] = 0;
+    }
+
+    // covered[i]: an ancestor of contour i produced a strong quad
+    std::vector<char> strong(C.size(), 0), covered(C.size(), 0);
+    size_t scored = 0, pruned = 0, skipped = 0;
+
+    for (size_t i : order)
+    {
+        int parent = opt.hierarchy ? hier[i][3] : -1;
+        if (parent >= 0)
+            covered[i] = covered[parent] || strong[parent];
+
+        if (!keep[i])
+        {
+            ++skipped;
+            continue;
+        }
+
+        // Outer boundaries and their holes are always scored, deeper
+        // contours only when no ancestor already yielded a document quad
+        if (depth[i] >= 2 && covered[i])
+        {
+            ++pruned;
+            continue;
+        }
+        ++scored;
+
+        auto &cont = C[i];
+        size_t first = list.size(), firstRect = rects.size();
+
+        // 1. Polygon approximation with 4 sides
         std::vector<cv::Point> ap;
         cv::approxPolyDP(cont, ap, 0.005 * cv::arcLength(cont, true), true);
         if (ap.size() == 4 && cv::isContourConvex(ap))
         {
-            std::vector<Point2f> q(ap.begin(), ap.end());
+            Quad q{{ap[0], ap[1], ap[2], ap[3]}};
             orderCCW(q);
-            evalQuad(q, list, Aimg, W, H, eq, gray, medGrad);
+            evalQuad(q, list, ctx);
         }
+
+        // 2. Minimum area rectangle for each contour
+        Quad q;
+        cv::minAreaRect(cont).points(q.p);
+        orderCCW(q);
+        evalQuad(q, rects, ctx);
+
+        for (size_t k = first; k < list.size(); k++)
+            if (list[k].sc >= kStrongQuad)
+                strong[i] = 1;
+        for (size_t k = firstRect; k < rects.size(); k++)
+            if (rects[k].sc >= kStrongQuad)
+                strong[i] = 1;
     }
+    list.insert(list.end(), rects.begin(), rects.end());
 
-    // 2. Minimum area rectangle for each contour
-    for (auto &cont : C)
+    if (stats)
     {
-        cv::RotatedRect rr = cv::minAreaRect(cont);
-        Point2f r[4];
-        rr.points(r);
-        std::vector<Point2f> q(r, r + 4);
-        orderCCW(q);
-        evalQuad(q, list, Aimg, W, H, eq, gray, medGrad);
+        stats->contours = C.size();
+        stats->scored = scored;
+        stats->pruned = pruned;
+        stats->skipped = skipped;
     }
 
 #ifdef HAVE_OPENCV_XIMGPROC
     // 3. Line segment detection + RANSAC (optional)
     {
         Mat edges;
-        cv::Canny(eq, edges, 50, 150);
+        cv::Canny(ctx.eq(), edges, 50, 150);
         auto fld = cv::ximgproc::createFastLineDetector();
         std::vector<cv::Vec4f> segs;
         fld->detect(edges, segs);
@@ -76,44 +150,48 @@ std::vector<Point2f> detect(const Mat &img)
                 pts.emplace_back(segs[i][2], segs[i][3]);
             }
 
-            cv::RotatedRect rr = cv::minAreaRect(pts);
-            Point2f r[4];
-            rr.points(r);
-            std::vector<Point2f> q(r, r + 4);
+            Quad q;
+            cv::minAreaRect(pts).points(q.p);
             orderCCW(q);
-            evalQuad(q, list, Aimg, W, H, eq, gray, medGrad);
+            evalQuad(q, list, ctx);
         }
     }
 #endif
 
+    if (stats)
+        stats->quads = list.size();
+
     // Choose best score
-    std::vector<Point2f> best;
+    Quad best;
+    bool found = false;
     if (!list.empty())
     {
-        auto top = *std::max_element(list.begin(), list.end(),
-                                     [](auto &a, auto &b)
-                                     { return a.sc < b.sc; });
+        auto &top = *std::max_element(list.begin(), list.end(),
+                                      [](auto &a, auto &b)
+                                      { return a.sc < b.sc; });
         if (top.sc >= 0.3)
+        {
             best = top.q;
+            found = true;
+        }
     }
 
-    if (best.empty())
+    if (!found)
     {
         // Minimum area rectangle of largest contour
         auto &big = *std::max_element(C.begin(), C.end(), [](auto &a, auto &b)
                                       { return fabs(cv::contourArea(a)) < fabs(cv::contourArea(b)); });
-        cv::RotatedRect rr = cv::minAreaRect(big);
-        Point2f r[4];
-        rr.points(r);
-        best.assign(r, r + 4);
+        cv::minAreaRect(big).points(best.p);
         orderCCW(best);
     }
 
     // Refine ±2 px if border safe
-    if (borderFrac(best, W, H) < 0.2)
+    QuadEdges len = edgeLengths(best);
+    if (borderFrac(best, len, W, H) < 0.2)
     {
         for (int i = 0; i < 4; i++)
         {
+            // Edges move as they are refined, so L is recomputed here
             auto d = best[(i + 1) & 3] - best[i];
             double L = cv::norm(d);
             if (L > 0)
@@ -125,7 +203,10 @@ std::vector<Point2f> detect(const Mat &img)
         }
     }
 
-    for (auto &p : best)
-        clipPt(p, W, H);
+    clipQuad(best, W, H);
+
+    tm.stop();
+    if (stats)
+        stats->ms = tm.getTimeMilli();
     return best;
 }
\ No newline at end of file
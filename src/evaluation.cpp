@@ -2,23 +2,23 @@
 #include "evaluation.h"
 #include <cmath>
 
-double IoU(std::vector<Point2f> a, std::vector<Point2f> b)
+double IoU(const Quad &a, const Quad &b)
 {
-    if (a.size() != 4 || b.size() != 4)
-        return -1;
+    // Corners are rounded to integer pixels, as the reported metric always was
+    cv::Point A[4], B[4];
+    for (int i = 0; i < 4; i++)
+    {
+        A[i] = a[i];
+        B[i] = b[i];
+    }
+    Mat mA(4, 1, CV_32SC2, A), mB(4, 1, CV_32SC2, B);
 
-    std::vector<cv::Point> A, B;
-    for (auto &p : a)
-        A.emplace_back(p);
-    for (auto &p : b)
-        B.emplace_back(p);
-
-    double a1 = fabs(cv::contourArea(A));
-    double a2 = fabs(cv::contourArea(B));
+    double a1 = fabs(cv::contourArea(mA));
+    double a2 = fabs(cv::contourArea(mB));
 
     cv::Mat inter;
-    bool ok = cv::intersectConvexConvex(A, B, inter);
+    bool ok = cv::intersectConvexConvex(mA, mB, inter);
     double ai = (ok && !inter.empty()) ? fabs(cv::contourArea(inter)) : 0;
 
     return (a1 + a2 - ai) > 1e-5 ? ai / (a1 + a2 - ai) : 0;
-}
\ No newline at end of file
+}
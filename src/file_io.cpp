@@ -1,9 +1,21 @@
 #include "file_io.h"
 #include "geometry_utils.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
-void saveTxt(const fs::path& p, const std::vector<Point2f>& q) {
+/**
+ * Orders four parsed points into a quad; any other count yields no quad.
+ */
+static std::optional<Quad> toQuad(const std::vector<Point2f>& v) {
+    if(v.size() != 4) return std::nullopt;
+    Quad q;
+    std::copy(v.begin(), v.end(), q.begin());
+    orderCCW(q);
+    return q;
+}
+
+void saveTxt(const fs::path& p, const Quad& q) {
     std::ofstream f(p);
     f << "(" << (int)q[0].x << "," << (int)q[0].y << "),("
       << (int)q[1].x << "," << (int)q[1].y << "),("
@@ -11,13 +23,13 @@ void saveTxt(const fs::path& p, const std::vector<Point2f>& q) {
       << (int)q[3].x << "," << (int)q[3].y << ")\n";
 }
 
-std::vector<Point2f> readGtFromCoordinatesFile(const fs::path& coordFile, const std::string& imageName) {
+std::optional<Quad> readGtFromCoordinatesFile(const fs::path& coordFile, const std::string& imageName) {
     std::vector<Point2f> v;
     std::ifstream f(coordFile);
     
     if(!f.is_open()) {
         std::cerr << "Warning: Cannot open coordinates file: " << coordFile << std::endl;
-        return v;
+        return std::nullopt;
     }
     
     std::string line;
@@ -64,23 +76,18 @@ std::vector<Point2f> readGtFromCoordinatesFile(const fs::path& coordFile, const
     
     if(v.size() != 4) {
         std::cerr << "Warning: Expected 4 points for " << imageName << ", got " << v.size() << std::endl;
-        if(v.empty()) {
-            // Return default points to avoid crash
-            v = {Point2f(0,0), Point2f(100,0), Point2f(100,100), Point2f(0,100)};
-        }
     }
     
-    orderCCW(v);
-    return v;
+    return toQuad(v);
 }
 
-std::vector<Point2f> readGt(const fs::path& t) {
+std::optional<Quad> readGt(const fs::path& t) {
     std::vector<Point2f> v;
     std::ifstream f(t);
     
     if(!f.is_open()) {
         std::cerr << "Warning: Cannot open ground truth file: " << t << std::endl;
-        return v;
+        return std::nullopt;
     }
     
     char c;
@@ -96,12 +103,7 @@ std::vector<Point2f> readGt(const fs::path& t) {
     
     if(v.size() != 4) {
         std::cerr << "Warning: Expected 4 points in ground truth, got " << v.size() << std::endl;
-        if(v.empty()) {
-            // Return default points to avoid crash
-            v = {Point2f(0,0), Point2f(100,0), Point2f(100,100), Point2f(0,100)};
-        }
     }
     
-    orderCCW(v);
-    return v;
+    return toQuad(v);
 }
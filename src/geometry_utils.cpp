@@ -2,24 +2,34 @@
 #include "geometry_utils.h"
 #include <algorithm>
 
-void orderCCW(std::vector<Point2f> &q)
+/**
+ * Half-plane of v in atan2 order: (-pi, 0) -> 0, [0, pi) -> 1, pi -> 2.
+ */
+static int half(Point2f v)
 {
-    if (q.size() != 4)
-    {
-        std::cerr << "Error: orderCCW expects exactly 4 points, got " << q.size() << std::endl;
-        return;
-    }
+    if (v.y < 0)
+        return 0;
+    return (v.y > 0 || v.x >= 0) ? 1 : 2;
+}
 
+void orderCCW(Quad &q)
+{
     Point2f c(0, 0);
     for (auto &p : q)
         c += p;
     c *= 0.25f;
 
-    std::sort(q.begin(), q.end(), [&](const auto &a, const auto &b)
-              { return std::atan2(a.y - c.y, a.x - c.x) < std::atan2(b.y - c.y, b.x - c.x); });
+    // Same order as sorting by atan2 around the centroid, without trig:
+    // compare half-planes first, then the sign of the cross product
+    std::sort(q.begin(), q.end(), [&](const Point2f &a, const Point2f &b)
+              {
+        int ha = half(a - c), hb = half(b - c);
+        if (ha != hb)
+            return ha < hb;
+        return cross(c, a, b) > 0; });
 
-    size_t tl = 0;
-    for (size_t i = 1; i < 4; i++)
+    int tl = 0;
+    for (int i = 1; i < 4; i++)
     {
         if (q[i].y < q[tl].y || (q[i].y == q[tl].y && q[i].x < q[tl].x))
         {
@@ -29,18 +39,8 @@ void orderCCW(std::vector<Point2f> &q)
     std::rotate(q.begin(), q.begin() + tl, q.end());
 }
 
-bool crossSelf(const std::vector<Point2f> &q)
-{
-    auto z = [](Point2f a, Point2f b, Point2f c)
-    {
-        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
-    };
-    return z(q[0], q[1], q[2]) * z(q[0], q[1], q[3]) < 0 &&
-           z(q[2], q[3], q[0]) * z(q[2], q[3], q[1]) < 0;
-}
-
 void clipPt(Point2f &p, int W, int H)
 {
     p.x = std::clamp(p.x, 0.f, (float)(W - 1));
     p.y = std::clamp(p.y, 0.f, (float)(H - 1));
-}
\ No newline at end of file
+}
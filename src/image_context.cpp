@@ -0,0 +1,54 @@
+// src/image_context.cpp
+#include "image_context.h"
+#include "image_preprocessing.h"
+
+ImageContext::ImageContext(const Mat &img) : img_(img) {}
+
+const Mat &ImageContext::gray()
+{
+    if (gray_.empty())
+        cv::cvtColor(img_, gray_, cv::COLOR_BGR2GRAY);
+    return gray_;
+}
+
+const Mat &ImageContext::eq()
+{
+    if (eq_.empty())
+        equalize(gray(), eq_);
+    return eq_;
+}
+
+const Mat &ImageContext::sobel()
+{
+    if (sob_.empty())
+        cv::Sobel(eq(), sob_, kSobelDepth, 1, 1);
+    return sob_;
+}
+
+const Mat &ImageContext::mag()
+{
+    if (mag_.empty())
+        medGrad_ = edgeMask(eq(), mag_);
+    return mag_;
+}
+
+double ImageContext::medGrad()
+{
+    mag();
+    return medGrad_;
+}
+
+double ImageContext::graySum()
+{
+    if (graySum_ < 0)
+        graySum_ = cv::sum(gray())[0];
+    return graySum_;
+}
+
+size_t ImageContext::bytes() const
+{
+    size_t n = 0;
+    for (const Mat *m : {&gray_, &eq_, &sob_, &mag_})
+        n += m->total() * m->elemSize();
+    return n;
+}
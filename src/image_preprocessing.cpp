@@ -3,18 +3,28 @@
 #include <vector>
 #include <algorithm>
 
-double preprocessImage(const Mat &img, Mat &mag, Mat &eq)
+void equalize(const Mat &gray, Mat &eq)
 {
-    // Convert to grayscale and apply CLAHE
-    Mat gray;
-    cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
     cv::createCLAHE(3.875, cv::Size(9, 9))->apply(gray, eq);
+}
 
+double edgeMask(const Mat &eq, Mat &mag)
+{
     // Calculate gradients
     Mat sx, sy;
+#ifdef DOCSCAN_FIXED_POINT
+    // 16-bit Sobel with max(|gx|, |gy|) + min(|gx|, |gy|) / 4, within a few
+    // percent of the L2 magnitude (at most 1275, fits CV_16S). The L1 sum
+    // |gx| + |gy| overweights diagonals, which moved the Otsu cut and lost IoU
+    cv::Sobel(eq, sx, CV_16S, 1, 0);
+    cv::Sobel(eq, sy, CV_16S, 0, 1);
+    Mat ax = cv::abs(sx), ay = cv::abs(sy);
+    mag = cv::max(ax, ay) + cv::min(ax, ay) / 4;
+#else
     cv::Sobel(eq, sx, CV_32F, 1, 0);
     cv::Sobel(eq, sy, CV_32F, 0, 1);
     cv::magnitude(sx, sy, mag);
+#endif
 
     // Normalize and threshold
     double mx;
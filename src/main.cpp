@@ -3,19 +3,36 @@
 #include "evaluation.h"
 #include "visualization.h"
 #include "geometry_utils.h"
+#include "scan_quality.h"
+#include "synthetic_scene.h"
 #include <opencv2/opencv.hpp>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
+#include <optional>
 
 namespace fs = std::filesystem;
 using cv::Mat;
 using cv::Point2f;
 
+// Contours scored for scans the gate classifies as easy
+static const size_t kEasyMaxContours = 16;
+
+#ifdef DOCSCAN_FIXED_POINT
+static const char* kScoringPath = "fixed-point";
+#else
+static const char* kScoringPath = "float";
+#endif
+
 /**
  * Executes document detection on a single image.
+ * With gate on, the scan-quality gate may reject the image or route it to
+ * the reduced candidate path. Returns the IoU, 0 for a rejected image with
+ * ground truth, or -1 without ground truth.
  */
 static double exec(const fs::path& imgP, const fs::path& gtP, const fs::path& jsonDir, 
-                   const fs::path& coordFile = "") {
+                   const fs::path& coordFile = "", const DetectOptions& opt = {}, bool gate = false,
+                   DetectStats* stats = nullptr, ScanQuality* quality = nullptr) {
     std::cout << "Processing: " << imgP.filename() << std::endl;
     
     Mat src = cv::imread(imgP.string());
@@ -25,51 +42,87 @@ static double exec(const fs::path& imgP, const fs::path& gtP, const fs::path& js
     Mat mini;
     cv::resize(src, mini, {}, sc, sc, cv::INTER_AREA);
 
-    auto quad = detect(mini);
-    for(auto& p : quad) clipPt(p, mini.cols, mini.rows);
-    
-    // Save prediction in current directory
-    fs::path predFile = imgP.filename();
-    predFile = predFile.stem().string() + "_predc.txt";
-    saveTxt(predFile, quad);
-    std::cout << "Saved predictions to: " << predFile << std::endl;
-
     // Handle ground truth
-    std::vector<Point2f> gt;
-    double iou = -1;
+    std::optional<Quad> gtQuad;
     
     if(!coordFile.empty() && fs::exists(coordFile)) {
         // Use the coordinates.txt file
         std::string imgName = imgP.stem().string();
-        auto gt_orig = readGtFromCoordinatesFile(coordFile, imgName);
+        gtQuad = readGtFromCoordinatesFile(coordFile, imgName);
         
-        if(!gt_orig.empty()) {
+        if(gtQuad) {
             // Scale coordinates to match mini image dimensions
             // Original coordinates seem to be in full resolution, so scale them down
-            for(const auto& p : gt_orig) {
-                float scaled_x = p.x * sc;
-                float scaled_y = p.y * sc;
-                gt.emplace_back(scaled_x, scaled_y);
-            }
-            for(auto& p : gt) clipPt(p, mini.cols, mini.rows);
-            iou = IoU(quad, gt);
+            for(auto& p : *gtQuad) p = Point2f(p.x * sc, p.y * sc);
+            clipQuad(*gtQuad, mini.cols, mini.rows);
         }
     } else if(!gtP.empty() && fs::exists(gtP)) {
         // Use individual ground truth file
-        auto gt_orig = readGt(gtP);
-        for(const auto& p : gt_orig) {
-            // Scale from (0,0)-(449,599) to mini image dimensions
-            float scaled_x = (p.x / 449.0f) * (mini.cols - 1);
-            float scaled_y = (p.y / 599.0f) * (mini.rows - 1);
-            gt.emplace_back(scaled_x, scaled_y);
+        gtQuad = readGt(gtP);
+        if(gtQuad) {
+            for(auto& p : *gtQuad) {
+                // Scale from (0,0)-(449,599) to mini image dimensions
+                p.x = (p.x / 449.0f) * (mini.cols - 1);
+                p.y = (p.y / 599.0f) * (mini.rows - 1);
+            }
+            clipQuad(*gtQuad, mini.cols, mini.rows);
         }
-        for(auto& p : gt) clipPt(p, mini.cols, mini.rows);
+    }
+
+    // Gate on a thumbnail: rejects skip detection and only write their reason
+    ScanQuality sq;
+    if(gate) {
+        sq = assessScan(mini);
+        std::cout << "Scan class: " << toString(sq.cls) << " (sharpness=" << sq.sharpness << ", exposure="
+                  << sq.exposure << ", edges=" << sq.edgeDensity << ")" << std::endl;
+    }
+    if(quality) *quality = sq;
+    if(sq.cls == ScanClass::Reject) {
+        // A rejected page is a missed detection where ground truth exists
+        double iou = gtQuad ? 0.0 : -1.0;
+        fs::create_directories(jsonDir);
+        cv::FileStorage js((jsonDir / (imgP.stem().string() + ".json")).string(),
+                           cv::FileStorage::WRITE | cv::FileStorage::FORMAT_JSON);
+        js << "image" << imgP.filename().string()
+           << "scan_class" << toString(sq.cls)
+           << "reason" << toString(sq.reason)
+           << "iou" << iou
+           << "sharpness" << sq.sharpness
+           << "exposure" << sq.exposure
+           << "contrast" << sq.contrast
+           << "edge_density" << sq.edgeDensity;
+        js.release();
+        std::cout << '"' << imgP.filename().string() << "\": rejected (" << toString(sq.reason) << ")\n";
+        return iou;
+    }
+    DetectOptions dopt = opt;
+    if(sq.cls == ScanClass::Easy) dopt.maxContours = kEasyMaxContours;
+
+    ImageContext ctx(mini);
+    DetectStats ds;
+    auto quad = detect(ctx, dopt, &ds);
+    if(stats) *stats = ds;
+    std::cout << "Candidates: " << ds.scored << "/" << ds.contours << " contours scored ("
+              << ds.pruned << " pruned, " << ds.skipped << " skipped), " << ds.quads << " quads" << std::endl;
+    std::cout << "Memoized planes: " << ctx.bytes() / 1024 << " KB, detect " << ds.ms << " ms" << std::endl;
+    clipQuad(quad, mini.cols, mini.rows);
+    
+    // Save prediction in current directory
+    fs::path predFile = imgP.filename();
+    predFile = predFile.stem().string() + "_predc.txt";
+    saveTxt(predFile, quad);
+    std::cout << "Saved predictions to: " << predFile << std::endl;
+
+    Quad gt;
+    double iou = -1;
+    if(gtQuad) {
+        gt = *gtQuad;
         iou = IoU(quad, gt);
     }
     
-    if(gt.empty()) {
+    if(iou < 0) {
         // Create dummy ground truth for visualization
-        gt = {Point2f(0,0), Point2f(mini.cols-1,0), Point2f(mini.cols-1,mini.rows-1), Point2f(0,mini.rows-1)};
+        gt = {{Point2f(0,0), Point2f(mini.cols-1,0), Point2f(mini.cols-1,mini.rows-1), Point2f(0,mini.rows-1)}};
     }
 
     // Save JSON results
@@ -78,12 +131,13 @@ static double exec(const fs::path& imgP, const fs::path& gtP, const fs::path& js
                        cv::FileStorage::WRITE | cv::FileStorage::FORMAT_JSON);
     js << "image" << imgP.filename().string() 
        << "size" << "[" << mini.cols << mini.rows << "]"
-       << "quad" << quad 
-       << "gt_quad" << gt 
-       << "iou" << iou;
+       << "quad" << quad.vec() 
+       << "gt_quad" << gt.vec() 
+       << "iou" << iou
+       << "scan_class" << toString(sq.cls);
     js.release();
 
-    // Draw and save visualization
+    // Draw and save visualization (mini is not needed afterwards)
     fs::path outputDir = "output";
     fs::path outputPath = outputDir / (imgP.stem().string() + "_boxes.png");
     drawBoxes(mini, quad, gt, outputPath);
@@ -98,7 +152,8 @@ static double exec(const fs::path& imgP, const fs::path& gtP, const fs::path& js
  */
 int main(int argc, char** argv) {
     if(argc < 2) {
-        std::cout << "Usage: ./DocumentScanner img.png [gt.txt] | ./DocumentScanner --dataset DIR\n";
+        std::cout << "Usage: ./DocumentScanner img.png [gt.txt] [--gate] | ./DocumentScanner --dataset DIR [--prune] [--gate]"
+                     " | ./DocumentScanner --synthetic N [WIDTH]\n";
         return 0;
     }
     
@@ -106,8 +161,21 @@ int main(int argc, char** argv) {
     if(a1 == "--dataset") {
         fs::path dir = argv[2], json = dir / "json";
         fs::path coordFile = dir / "../ground_truth/coordinates.txt";
+        DetectOptions opt;
+        bool gate = false;
+        for(int a = 3; a < argc; a++) {
+            std::string s = argv[a];
+            if(s == "--prune") opt.hierarchy = true;
+            else if(s == "--gate") gate = true;
+        }
         double sum = 0;
-        int n = 0;
+        int n = 0, rejects = 0;
+        size_t contours = 0, scored = 0;
+        double ms = 0;
+        int imgs = 0;
+        // Per scan class: image count and total exec() time
+        int classN[3] = {0, 0, 0};
+        double classMs[3] = {0, 0, 0};
         
         for(int k = 1; k <= 10; k++) {
             fs::path img = dir / ("img_" + std::to_string(k) + ".png");
@@ -118,7 +186,20 @@ int main(int argc, char** argv) {
             if(!fs::exists(img)) continue;
             
             try {
-                double i = exec(img, "", json, coordFile);
+                DetectStats ds;
+                ScanQuality sq;
+                cv::TickMeter tm;
+                tm.start();
+                double i = exec(img, "", json, coordFile, opt, gate, &ds, &sq);
+                tm.stop();
+                classN[(int)sq.cls]++;
+                classMs[(int)sq.cls] += tm.getTimeMilli();
+                contours += ds.contours;
+                scored += ds.scored;
+                ms += ds.ms;
+                if(sq.cls == ScanClass::Reject) rejects++;
+                else imgs++;
+                // Rejects with ground truth come back as IoU 0
                 if(i >= 0) {
                     sum += i;
                     n++;
@@ -128,15 +209,55 @@ int main(int argc, char** argv) {
             }
         }
         
-        if(n) std::cout << "Mean IoU=" << sum / n << "\n";
+        if(n) std::cout << "Mean IoU=" << sum / n << " over " << n << " images with ground truth\n";
+        if(gate) std::cout << "Rejected by the scan-quality gate: " << rejects
+                           << " (scored as IoU 0 where ground truth exists)\n";
+        std::cout << "Contours scored: " << scored << "/" << contours
+                  << (opt.hierarchy ? " (hierarchy pruning)" : " (flat)") << "\n";
+        if(ms > 0) std::cout << "Detect throughput: " << 1000.0 * imgs / ms << " img/s ("
+                             << kScoringPath << ")\n";
+        for(ScanClass c : {ScanClass::Reject, ScanClass::Easy, ScanClass::Hard}) {
+            int k = (int)c;
+            if(classN[k] && classMs[k] > 0)
+                std::cout << "Class " << toString(c) << ": " << classN[k] << " images, "
+                          << 1000.0 * classN[k] / classMs[k] << " img/s\n";
+        }
+    } else if(a1 == "--synthetic") {
+        // Generated scenes with known quads, at a configurable resolution
+        int count = argc > 2 ? std::atoi(argv[2]) : 100;
+        SceneParams p;
+        if(argc > 3) {
+            p.width = std::atoi(argv[3]);
+            p.height = p.width * 4 / 3;
+        }
+        double sum = 0, ms = 0;
+        for(int k = 0; k < count; k++) {
+            Scene s = renderScene(k, p);
+            DetectStats ds;
+            Quad quad = detect(s.img, {}, &ds);
+            sum += IoU(quad, s.quad);
+            ms += ds.ms;
+        }
+        if(count > 0) {
+            std::cout << "Synthetic " << p.width << "x" << p.height << ": mean IoU=" << sum / count
+                      << ", detect throughput: " << 1000.0 * count / ms << " img/s (" << kScoringPath << ")\n";
+        }
     } else {
         fs::path img = a1;
-        fs::path gt = (argc > 2 ? fs::path(argv[2]) : fs::path());
+        fs::path gt;
+        bool gate = false;
+        for(int a = 2; a < argc; a++) {
+            std::string s = argv[a];
+            if(s == "--gate") gate = true;
+            else if(gt.empty()) gt = s;
+        }
         fs::path jsonDir = "json";
         fs::path coordFile = "../data/ground_truth/coordinates.txt";
         
         try {
-            exec(img, gt, jsonDir, coordFile);
+            ScanQuality sq;
+            exec(img, gt, jsonDir, coordFile, {}, gate, nullptr, &sq);
+            if(sq.cls == ScanClass::Reject) return 2;
         } catch(const std::exception& e) {
             std::cerr << e.what() << "\n";
         }
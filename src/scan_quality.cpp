@@ -0,0 +1,148 @@
+// src/scan_quality.cpp
+#include "scan_quality.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+// Gate thresholds. kMinSharpness separates synthetic pages blurred by
+// sigma <= 2 from sigma >= 3; the others are uncalibrated starting points.
+static const double kMinExposure = 30;       // mean gray, darker is underexposed
+static const double kMinContrast = 8;        // gray std, flatter is blank
+static const double kMaxExposure = 235;      // brighter and below kMinOverContrast
+static const double kMinOverContrast = 20;   // is overexposed
+static const int kSharpSide = 300;           // longest side for the sharpness copy
+static const int kSharpMinGrad = 192;        // L1 gradient of pixels on real edges
+static const double kMinSharpness = 0.07;    // lower is blurry
+static const double kMinEdgeDensity = 0.005; // fewer edge pixels is no edges
+static const double kEasyMinContrast = 40;   // page clearly apart from background
+static const double kEasyMaxEdgeDensity = 0.12;
+static const double kEasyMaxMidShare = 0.5;  // share of edges in the weakest edge bin
+
+/**
+ * Gray copy of img with its longest side at most side pixels.
+ */
+static Mat grayCopy(const Mat &img, int side)
+{
+    Mat small, gray;
+    double sc = std::min(1.0, (double)side / std::max(img.cols, img.rows));
+    cv::resize(img, small, {}, sc, sc, cv::INTER_AREA);
+    if (small.channels() == 3)
+        cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    else
+        gray = small;
+    return gray;
+}
+
+/**
+ * L1 gradient magnitude |gx| + |gy| in CV_16S.
+ */
+static Mat l1Gradient(const Mat &gray)
+{
+    Mat gx, gy;
+    cv::Sobel(gray, gx, CV_16S, 1, 0);
+    cv::Sobel(gray, gy, CV_16S, 0, 1);
+    return cv::abs(gx) + cv::abs(gy);
+}
+
+ScanQuality assessScan(const Mat &img)
+{
+    ScanQuality sq;
+
+    // Thumbnail, longest side 128 px
+    Mat gray = grayCopy(img, 128);
+
+    cv::Scalar m, sd;
+    cv::meanStdDev(gray, m, sd);
+    sq.exposure = m[0];
+    sq.contrast = sd[0];
+
+    // Histogram over [0, 1024) in 8 bins; everything above the first bin
+    // counts as an edge pixel
+    Mat mag = l1Gradient(gray);
+    for (int r = 0; r < mag.rows; r++)
+    {
+        const short *row = mag.ptr<short>(r);
+        for (int c = 0; c < mag.cols; c++)
+            sq.edgeHist[std::min(row[c] >> 7, 7)] += 1;
+    }
+    for (auto &h : sq.edgeHist)
+        h /= (float)mag.total();
+    sq.edgeDensity = 1.0 - sq.edgeHist[0];
+
+    // Sharpness on a larger copy, since the thumbnail hides moderate blur:
+    // |Laplacian| relative to the gradient on edge pixels falls roughly as
+    // 1 / sigma and does not depend on how much of the frame is edges
+    Mat mid = grayCopy(img, kSharpSide), lap;
+    Mat grad = l1Gradient(mid);
+    cv::Laplacian(mid, lap, CV_16S);
+    int64_t sLap = 0, sGrad = 0;
+    for (int r = 0; r < grad.rows; r++)
+    {
+        const short *g = grad.ptr<short>(r), *l = lap.ptr<short>(r);
+        for (int c = 0; c < grad.cols; c++)
+        {
+            if (g[c] >= kSharpMinGrad)
+            {
+                sLap += std::abs(l[c]);
+                sGrad += g[c];
+            }
+        }
+    }
+    sq.sharpness = sGrad ? (double)sLap / sGrad : 0;
+
+    // Rejects, cheapest evidence first
+    if (sq.exposure < kMinExposure)
+        sq.reason = RejectReason::Underexposed;
+    else if (sq.contrast < kMinContrast)
+        sq.reason = RejectReason::Blank;
+    else if (sq.exposure > kMaxExposure && sq.contrast < kMinOverContrast)
+        sq.reason = RejectReason::Overexposed;
+    else if (sq.sharpness < kMinSharpness)
+        sq.reason = RejectReason::Blurry;
+    else if (sq.edgeDensity < kMinEdgeDensity)
+        sq.reason = RejectReason::NoEdges;
+
+    // Page borders and print give sharp edges; textured or cluttered
+    // backgrounds add many edges in the weakest edge bin
+    bool sharp = sq.edgeHist[1] <= kEasyMaxMidShare * sq.edgeDensity;
+
+    if (sq.reason != RejectReason::None)
+        sq.cls = ScanClass::Reject;
+    else if (sq.edgeDensity < kEasyMaxEdgeDensity && sq.contrast > kEasyMinContrast && sharp)
+        sq.cls = ScanClass::Easy; // page on an uncluttered background
+    else
+        sq.cls = ScanClass::Hard;
+    return sq;
+}
+
+const char *toString(ScanClass c)
+{
+    switch (c)
+    {
+    case ScanClass::Reject:
+        return "reject";
+    case ScanClass::Easy:
+        return "easy";
+    default:
+        return "hard";
+    }
+}
+
+const char *toString(RejectReason r)
+{
+    switch (r)
+    {
+    case RejectReason::Underexposed:
+        return "underexposed";
+    case RejectReason::Overexposed:
+        return "overexposed";
+    case RejectReason::Blank:
+        return "blank";
+    case RejectReason::Blurry:
+        return "blurry";
+    case RejectReason::NoEdges:
+        return "no_edges";
+    default:
+        return "none";
+    }
+}
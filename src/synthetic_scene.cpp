@@ -0,0 +1,143 @@
+// src/synthetic_scene.cpp
+#include "synthetic_scene.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Fills the frame with one of the background styles.
+ */
+static void drawBackground(Mat &img, int style, cv::RNG &rng)
+{
+    cv::Scalar base(rng.uniform(20, 140), rng.uniform(20, 140), rng.uniform(20, 140));
+    img.setTo(base);
+
+    switch (style)
+    {
+    case 1: // Vertical gradient
+        for (int y = 0; y < img.rows; y++)
+            img.row(y).setTo(base * (0.5 + (double)y / img.rows));
+        break;
+    case 2: // Stripes, e.g. desk or floor boards
+    {
+        int step = rng.uniform(8, 40);
+        cv::Scalar dark = base * 0.7;
+        for (int x = 0; x < img.cols; x += step)
+            cv::line(img, {x, 0}, {x, img.rows - 1}, dark, rng.uniform(1, 4));
+        break;
+    }
+    case 3: // Smooth random texture
+    {
+        Mat tex(img.size(), CV_8UC3);
+        rng.fill(tex, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+        cv::GaussianBlur(tex, tex, {}, 6);
+        cv::addWeighted(img, 0.6, tex, 0.4, 0, img);
+        break;
+    }
+    default: // Flat
+        break;
+    }
+}
+
+/**
+ * Draws rectangles, circles and lines as distractors.
+ */
+static void drawClutter(Mat &img, int n, cv::RNG &rng)
+{
+    int W = img.cols, H = img.rows;
+    for (int i = 0; i < n; i++)
+    {
+        cv::Scalar c(rng.uniform(0, 200), rng.uniform(0, 200), rng.uniform(0, 200));
+        cv::Point a(rng.uniform(0, W), rng.uniform(0, H));
+        int r = rng.uniform(5, std::max(6, std::min(W, H) / 8));
+        switch (rng.uniform(0, 3))
+        {
+        case 0:
+            cv::rectangle(img, a, a + cv::Point(r, r / 2 + 1), c, cv::FILLED);
+            break;
+        case 1:
+            cv::circle(img, a, r, c, cv::FILLED);
+            break;
+        default:
+            cv::line(img, a, {rng.uniform(0, W), rng.uniform(0, H)}, c, rng.uniform(1, 4));
+            break;
+        }
+    }
+}
+
+/**
+ * Paper with dark text lines and an occasional header block.
+ */
+static Mat renderPage(int pw, int ph, cv::RNG &rng)
+{
+    int paper = rng.uniform(225, 256);
+    Mat page(ph, pw, CV_8UC3, cv::Scalar(paper, paper, paper - rng.uniform(0, 15)));
+
+    int margin = std::max(2, pw / 10);
+    int lineH = std::max(2, ph / 60);
+    int y = margin;
+    if (rng.uniform(0, 2))
+    {
+        cv::rectangle(page, {margin, y}, {pw / 2, y + 3 * lineH}, cv::Scalar(60, 60, 60), cv::FILLED);
+        y += 5 * lineH;
+    }
+    for (; y < ph - margin; y += 2 * lineH)
+    {
+        int x1 = pw - margin - rng.uniform(0, std::max(1, pw / 3));
+        cv::rectangle(page, {margin, y}, {x1, y + lineH - 1}, cv::Scalar(40, 40, 40), cv::FILLED);
+    }
+    return page;
+}
+
+Scene renderScene(uint64_t seed, const SceneParams &p)
+{
+    cv::RNG rng(seed);
+    int W = p.width, H = p.height;
+
+    Scene s;
+    s.img.create(H, W, CV_8UC3);
+    drawBackground(s.img, p.background >= 0 ? p.background : rng.uniform(0, 4), rng);
+    drawClutter(s.img, p.clutter, rng);
+
+    // A4-shaped page covering 30-55% of the frame
+    double area = rng.uniform(0.30, 0.55) * W * H;
+    double pw = std::sqrt(area / 1.414), ph = 1.414 * pw;
+    double fit = std::min({1.0, 0.8 * W / pw, 0.8 * H / ph});
+    pw = std::floor(pw * fit);
+    ph = std::floor(ph * fit);
+
+    // Place, rotate and offset the corners independently for perspective
+    Point2f c(W * 0.5f + (float)rng.uniform(-0.05, 0.05) * W,
+              H * 0.5f + (float)rng.uniform(-0.05, 0.05) * H);
+    double ang = rng.uniform(-12.0, 12.0) * CV_PI / 180;
+    double ca = std::cos(ang), sa = std::sin(ang);
+    const double ux[4] = {-0.5, 0.5, 0.5, -0.5}, uy[4] = {-0.5, -0.5, 0.5, 0.5};
+
+    Point2f src[4], dst[4];
+    for (int i = 0; i < 4; i++)
+    {
+        double x = ux[i] * pw + rng.uniform(-p.perspective, p.perspective) * pw;
+        double y = uy[i] * ph + rng.uniform(-p.perspective, p.perspective) * pw;
+        dst[i] = Point2f(c.x + (float)(ca * x - sa * y), c.y + (float)(sa * x + ca * y));
+        clipPt(dst[i], W, H);
+        src[i] = Point2f((float)((ux[i] + 0.5) * (pw - 1)), (float)((uy[i] + 0.5) * (ph - 1)));
+    }
+
+    Mat page = renderPage((int)pw, (int)ph, rng);
+    Mat M = cv::getPerspectiveTransform(src, dst);
+    cv::warpPerspective(page, s.img, M, s.img.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+
+    if (p.blur > 0)
+        cv::GaussianBlur(s.img, s.img, {}, p.blur);
+    if (p.noise > 0)
+    {
+        Mat n(s.img.size(), CV_16SC3), acc;
+        rng.fill(n, cv::RNG::NORMAL, cv::Scalar::all(0), cv::Scalar::all(p.noise));
+        s.img.convertTo(acc, CV_16SC3);
+        acc += n;
+        acc.convertTo(s.img, CV_8UC3);
+    }
+
+    std::copy(dst, dst + 4, s.quad.begin());
+    orderCCW(s.quad);
+    return s;
+}
@@ -1,40 +1,32 @@
 // src/visualization.cpp
 #include "visualization.h"
 
-void drawBoxes(const Mat &img, const std::vector<Point2f> &detected,
-               const std::vector<Point2f> &gt, const fs::path &outputPath)
+/**
+ * Draws a closed quad outline with a label above its first corner.
+ */
+static void drawQuad(Mat &result, const Quad &q, const char *label, const cv::Scalar &color)
 {
-    Mat result = img.clone();
-
-    // Draw ground truth box in green
-    if (gt.size() == 4)
+    cv::Point poly[4];
+    for (int i = 0; i < 4; i++)
     {
-        std::vector<cv::Point> gtPoly;
-        for (const auto &p : gt)
-        {
-            gtPoly.push_back(cv::Point((int)p.x, (int)p.y));
-        }
-        cv::polylines(result, gtPoly, true, cv::Scalar(0, 255, 0), 3); // Green
-
-        // Add labels
-        cv::putText(result, "GT", cv::Point((int)gt[0].x, (int)gt[0].y - 10),
-                    cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 255, 0), 2);
+        poly[i] = cv::Point((int)q[i].x, (int)q[i].y);
     }
+    const cv::Point *pts = poly;
+    int n = 4;
+    cv::polylines(result, &pts, &n, 1, true, color, 3);
 
-    // Draw detected box in red
-    if (detected.size() == 4)
-    {
-        std::vector<cv::Point> detPoly;
-        for (const auto &p : detected)
-        {
-            detPoly.push_back(cv::Point((int)p.x, (int)p.y));
-        }
-        cv::polylines(result, detPoly, true, cv::Scalar(0, 0, 255), 3); // Red
+    // Add labels
+    cv::putText(result, label, cv::Point(poly[0].x, poly[0].y - 10),
+                cv::FONT_HERSHEY_SIMPLEX, 1.0, color, 2);
+}
 
-        // Add labels
-        cv::putText(result, "DET", cv::Point((int)detected[0].x, (int)detected[0].y - 10),
-                    cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0, 0, 255), 2);
-    }
+void drawBoxes(Mat &result, const Quad &detected, const Quad &gt, const fs::path &outputPath)
+{
+    // Draw ground truth box in green
+    drawQuad(result, gt, "GT", cv::Scalar(0, 255, 0));
+
+    // Draw detected box in red
+    drawQuad(result, detected, "DET", cv::Scalar(0, 0, 255));
 
     // Save the result
     fs::create_directories(outputPath.parent_path());
@@ -0,0 +1,399 @@
+// tests/test_document_scanner.cpp
+#include "document_detector.h"
+#include "evaluation.h"
+#include "file_io.h"
+#include "geometry_utils.h"
+#include "scan_quality.h"
+#include "synthetic_scene.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static int failures = 0;
+
+#define CHECK(cond)                                                              \
+    do                                                                           \
+    {                                                                            \
+        if (!(cond))                                                             \
+        {                                                                        \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond \
+                      << std::endl;                                              \
+            ++failures;                                                          \
+        }                                                                        \
+    } while (0)
+
+static bool sameQuad(const Quad &a, const Quad &b)
+{
+    return std::memcmp(a.p, b.p, sizeof(a.p)) == 0;
+}
+
+/**
+ * Golden corpus: varied resolution, background, blur, noise and clutter.
+ */
+static const uint64_t kCorpusSeed = 1000;
+
+static std::vector<Scene> corpus()
+{
+    std::vector<Scene> scenes;
+    for (int k = 0; k < 24; k++)
+    {
+        SceneParams p;
+        if (k % 6 == 5)
+        {
+            p.width = 900;
+            p.height = 1200;
+        }
+        p.background = k % 4;
+        p.blur = (k % 3) * 1.0;
+        p.noise = 2.0 + (k % 5) * 2.0;
+        p.clutter = k % 8;
+        scenes.push_back(renderScene(kCorpusSeed + k, p));
+    }
+    return scenes;
+}
+
+static void testGeometry()
+{
+    Quad q{{Point2f(100, 200), Point2f(10, 10), Point2f(10, 200), Point2f(100, 10)}};
+    orderCCW(q);
+    CHECK(q[0] == Point2f(10, 10));
+    CHECK(q[1] == Point2f(100, 10));
+    CHECK(q[2] == Point2f(100, 200));
+    CHECK(q[3] == Point2f(10, 200));
+
+    CHECK(quadArea(q) == 90.0 * 190.0);
+    CHECK(isConvex(q));
+    CHECK(!crossSelf(q));
+
+    QuadEdges len = edgeLengths(q);
+    CHECK(len[0] == 90.f && len[1] == 190.f && len[2] == 90.f && len[3] == 190.f);
+
+    Quad bow{{Point2f(0, 0), Point2f(10, 10), Point2f(10, 0), Point2f(0, 10)}};
+    CHECK(crossSelf(bow));
+    CHECK(!isConvex(bow));
+
+    Quad out{{Point2f(-5, -5), Point2f(50, -1), Point2f(120, 80), Point2f(-3, 90)}};
+    clipQuad(out, 100, 60);
+    CHECK(out[0] == Point2f(0, 0));
+    CHECK(out[2] == Point2f(99, 59));
+}
+
+/**
+ * Reference ordering by atan2 around the centroid, as before the Quad type.
+ */
+static void orderByAngle(Quad &q)
+{
+    Point2f c(0, 0);
+    for (auto &p : q)
+        c += p;
+    c *= 0.25f;
+
+    std::sort(q.begin(), q.end(), [&](const Point2f &a, const Point2f &b)
+              { return std::atan2(a.y - c.y, a.x - c.x) < std::atan2(b.y - c.y, b.x - c.x); });
+
+    int tl = 0;
+    for (int i = 1; i < 4; i++)
+    {
+        if (q[i].y < q[tl].y || (q[i].y == q[tl].y && q[i].x < q[tl].x))
+        {
+            tl = i;
+        }
+    }
+    std::rotate(q.begin(), q.begin() + tl, q.end());
+}
+
+static void testOrderCCW()
+{
+    // minAreaRect-style rotated rectangles and arbitrary point sets
+    cv::RNG rng(12345);
+    int mismatch = 0;
+    for (int k = 0; k < 20000; k++)
+    {
+        Quad q;
+        if (k & 1)
+        {
+            for (auto &p : q)
+                p = Point2f(rng.uniform(0.f, 450.f), rng.uniform(0.f, 600.f));
+        }
+        else
+        {
+            cv::RotatedRect rr({rng.uniform(0.f, 450.f), rng.uniform(0.f, 600.f)},
+                               {rng.uniform(20.f, 450.f), rng.uniform(20.f, 600.f)},
+                               rng.uniform(0.f, 180.f));
+            rr.points(q.p);
+        }
+        Quad a = q, b = q;
+        orderByAngle(a);
+        orderCCW(b);
+        mismatch += !sameQuad(a, b);
+    }
+    CHECK(mismatch == 0);
+}
+
+static void testIoU()
+{
+    Quad a{{Point2f(0, 0), Point2f(10, 0), Point2f(10, 10), Point2f(0, 10)}};
+    Quad b{{Point2f(5, 0), Point2f(15, 0), Point2f(15, 10), Point2f(5, 10)}};
+    Quad c{{Point2f(20, 20), Point2f(30, 20), Point2f(30, 30), Point2f(20, 30)}};
+    CHECK(std::abs(IoU(a, a) - 1.0) < 1e-6);
+    CHECK(std::abs(IoU(a, b) - 1.0 / 3.0) < 1e-6);
+    CHECK(IoU(a, c) == 0.0);
+}
+
+static void testFileIo()
+{
+    fs::path t = fs::temp_directory_path() / "test_document_scanner_gt.txt";
+    Quad q{{Point2f(12, 15), Point2f(300, 20), Point2f(290, 410), Point2f(8, 400)}};
+    saveTxt(t, q);
+    auto r = readGt(t);
+    CHECK(r && sameQuad(q, *r));
+
+    // A partial quad is reported as missing, not replaced by a default
+    std::ofstream(t) << "(1,2),(3,4),(5,6)\n";
+    CHECK(!readGt(t));
+    fs::remove(t);
+    CHECK(!readGt(t));
+}
+
+static void testGenerator()
+{
+    Scene a = renderScene(42), b = renderScene(42), c = renderScene(43);
+    CHECK(cv::norm(a.img, b.img, cv::NORM_INF) == 0);
+    CHECK(sameQuad(a.quad, b.quad));
+    CHECK(!sameQuad(a.quad, c.quad));
+    CHECK(isConvex(a.quad) && !crossSelf(a.quad));
+}
+
+static void testScanQuality()
+{
+    ScanQuality dark = assessScan(Mat(600, 450, CV_8UC3, cv::Scalar::all(10)));
+    CHECK(dark.cls == ScanClass::Reject && dark.reason == RejectReason::Underexposed);
+
+    ScanQuality blank = assessScan(Mat(600, 450, CV_8UC3, cv::Scalar::all(240)));
+    CHECK(blank.cls == ScanClass::Reject && blank.reason == RejectReason::Blank);
+
+    Scene s = renderScene(7);
+    CHECK(assessScan(s.img).cls != ScanClass::Reject);
+
+    // Realistic defocus on the same page, and a smeared one
+    Mat blurred, smeared;
+    cv::GaussianBlur(s.img, blurred, {}, 3);
+    ScanQuality soft = assessScan(blurred);
+    CHECK(soft.cls == ScanClass::Reject && soft.reason == RejectReason::Blurry);
+    cv::GaussianBlur(s.img, smeared, {}, 25);
+    CHECK(assessScan(smeared).cls == ScanClass::Reject);
+
+    // A plain page on a flat background takes the easy path
+    Mat page(600, 450, CV_8UC3, cv::Scalar(70, 90, 110));
+    Quad pq{{Point2f(90, 110), Point2f(370, 95), Point2f(385, 500), Point2f(80, 490)}};
+    cv::Point poly[4];
+    for (int i = 0; i < 4; i++)
+        poly[i] = pq[i];
+    cv::fillConvexPoly(page, poly, 4, cv::Scalar(235, 238, 240));
+    ScanQuality doc = assessScan(page);
+    CHECK(doc.cls == ScanClass::Easy);
+
+    // The reduced candidate path still finds it
+    DetectOptions easy;
+    easy.maxContours = 16;
+    DetectStats ds;
+    CHECK(IoU(detect(page, easy, &ds), pq) >= 0.8);
+    CHECK(ds.scored <= 16);
+}
+
+// Detection on the corpus is held to the scene GT, to the serial float run
+// of the same binary and, once recorded, to data/golden/synthetic_quads.txt.
+// Recorded corners depend on the OpenCV build (SIMD dispatch in CLAHE,
+// Sobel and warpPerspective), so the stored file is compared with a tolerance.
+static const double kMinMeanIoU = 0.7; // serial run against scene GT
+static const double kAgreeIoU = 0.95;  // per scene, against the reference run
+static const double kMaxDrift = 0.02;  // mean IoU drift from the reference run
+static const double kFixedDrift = 0.05; // fixed-point mean IoU drift from float golden quads
+
+/**
+ * How closely a run must follow its reference.
+ */
+enum class Match
+{
+    Exact, // bit for bit
+    Close, // kAgreeIoU per scene and kMaxDrift in mean IoU
+    Mean   // kMaxDrift in mean IoU only; the run may pick other quads
+};
+
+/**
+ * Writes seed and quad per corpus scene, corners as hex floats.
+ */
+static int recordGolden(const fs::path &file)
+{
+#ifdef DOCSCAN_FIXED_POINT
+    std::cerr << "Record golden quads from a float build" << std::endl;
+    return 1;
+#else
+    std::vector<Scene> scenes = corpus();
+    fs::create_directories(file.parent_path());
+    std::ofstream f(file);
+    f << "# OpenCV " << CV_VERSION << ", recorded by test_document_scanner --record\n"
+      << "# seed x0 y0 x1 y1 x2 y2 x3 y3\n";
+    for (size_t i = 0; i < scenes.size(); i++)
+    {
+        Quad q = detect(scenes[i].img);
+        f << kCorpusSeed + i << std::hexfloat;
+        for (auto &p : q)
+            f << ' ' << p.x << ' ' << p.y;
+        f << std::defaultfloat << '\n';
+    }
+    std::cout << "Recorded " << scenes.size() << " quads to " << file << std::endl;
+    return 0;
+#endif
+}
+
+static std::vector<Quad> readGolden(const fs::path &file)
+{
+    std::vector<Quad> golden;
+    std::ifstream f(file);
+    std::string line;
+    while (std::getline(f, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream iss(line);
+        std::string tok[9];
+        for (auto &t : tok)
+            iss >> t;
+        Quad q;
+        for (int k = 0; k < 4; k++)
+            q[k] = Point2f(std::strtof(tok[1 + 2 * k].c_str(), nullptr),
+                           std::strtof(tok[2 + 2 * k].c_str(), nullptr));
+        golden.push_back(q);
+    }
+    return golden;
+}
+
+/**
+ * Compares a detection run with a reference run on the same scenes.
+ */
+static void compareRuns(const char *name, const std::vector<Scene> &scenes,
+                        const std::vector<Quad> &ref, const std::vector<Quad> &got, Match match,
+                        double maxDrift = kMaxDrift)
+{
+    double sumRef = 0, sumGot = 0;
+    for (size_t i = 0; i < scenes.size(); i++)
+    {
+        double agree = IoU(got[i], ref[i]);
+        bool ok = match == Match::Exact   ? sameQuad(got[i], ref[i])
+                  : match == Match::Close ? agree >= kAgreeIoU
+                                          : true;
+        if (!ok)
+            std::cerr << name << ": scene " << i << " differs (IoU " << agree << ")" << std::endl;
+        CHECK(ok);
+        sumRef += IoU(ref[i], scenes[i].quad);
+        sumGot += IoU(got[i], scenes[i].quad);
+    }
+    size_t n = scenes.size();
+    std::cout << name << ": mean IoU=" << sumGot / n << " (reference " << sumRef / n << ")" << std::endl;
+    CHECK(sumGot / n >= sumRef / n - maxDrift);
+}
+
+static void testGolden()
+{
+    std::vector<Scene> scenes = corpus();
+    size_t n = scenes.size();
+
+    // Serial default run, the reference for everything below
+    std::vector<Quad> serial(n);
+    std::vector<DetectStats> stats(n);
+    double sum = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        serial[i] = detect(scenes[i].img, {}, &stats[i]);
+        sum += IoU(serial[i], scenes[i].quad);
+    }
+    std::cout << "serial: mean IoU=" << sum / n << std::endl;
+    CHECK(sum / n >= kMinMeanIoU);
+
+    // Concurrent detection must not perturb any result
+    std::vector<Quad> parallel(n);
+    cv::parallel_for_(cv::Range(0, (int)n), [&](const cv::Range &r)
+                      {
+        for (int i = r.start; i < r.end; i++)
+            parallel[i] = detect(scenes[i].img); });
+    compareRuns("parallel", scenes, serial, parallel, Match::Exact);
+
+    // Reduced candidate set used for easy scans
+    DetectOptions reduced;
+    reduced.maxContours = 16;
+    std::vector<Quad> top(n);
+    for (size_t i = 0; i < n; i++)
+        top[i] = detect(scenes[i].img, reduced);
+    compareRuns("maxContours", scenes, serial, top, Match::Close);
+
+    // Pruning never scores more contours than the flat run. Whether it
+    // fires depends on kStrongQuad, so only the corpus total must drop;
+    // dropping a deep contour may change the winning quad on a scene
+    DetectOptions prune;
+    prune.hierarchy = true;
+    std::vector<Quad> pruned(n);
+    size_t scored = 0, scoredFlat = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        DetectStats ds;
+        pruned[i] = detect(scenes[i].img, prune, &ds);
+        CHECK(ds.scored <= stats[i].scored);
+        scored += ds.scored;
+        scoredFlat += stats[i].scored;
+    }
+    std::cout << "hierarchy: scored " << scored << "/" << scoredFlat << " contours" << std::endl;
+    CHECK(scored < scoredFlat);
+    compareRuns("hierarchy", scenes, serial, pruned, Match::Mean);
+
+    // Stored quads from a float build; the fixed-point build is held to them too
+    std::vector<Quad> golden = readGolden(DOCSCAN_GOLDEN_FILE);
+    if (golden.empty())
+    {
+        std::cout << "golden: " << DOCSCAN_GOLDEN_FILE
+                  << " not recorded, skipped (test_document_scanner --record)" << std::endl;
+        return;
+    }
+    CHECK(golden.size() == n);
+    if (golden.size() == n)
+    {
+#ifdef DOCSCAN_FIXED_POINT
+        // Integer magnitudes move the Otsu cut, so single scenes may differ
+        compareRuns("golden", scenes, golden, serial, Match::Mean, kFixedDrift);
+#else
+        compareRuns("golden", scenes, golden, serial, Match::Close);
+#endif
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "--record")
+        return recordGolden(argc > 2 ? fs::path(argv[2]) : fs::path(DOCSCAN_GOLDEN_FILE));
+
+    testGeometry();
+    testOrderCCW();
+    testIoU();
+    testFileIo();
+    testGenerator();
+    testScanQuality();
+    testGolden();
+
+    if (failures)
+    {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}